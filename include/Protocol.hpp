@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// compact binary wire protocol for online play
+//
+// every message is a fixed 4-byte header followed by a fixed-width payload:
+//   [u16 length][u8 version][u8 type][payload...]
+// length counts the whole message (header included), all fields little-endian.
+// messages only describe what changed in a turn (the token that moved, the
+// token that was sent home), never the whole board.
+
+// bump whenever a message is added or changes layout. v2 added MSG_SEATS.
+const std::uint8_t PROTO_VERSION = 2;
+const std::size_t  MSG_HEADER    = 4;
+
+enum MsgType : std::uint8_t {
+    MSG_ROLL = 1,    // player, value
+    MSG_MOVE,        // player, token, from step, to step
+    MSG_CAPTURE,     // player, victim player, victim token
+    MSG_FINISH,      // player, final rank
+    MSG_FORFEIT,     // player
+    MSG_TURN,        // next player
+    MSG_SEATS,       // bitmask of cpu-controlled players
+    MSG_TYPE_COUNT
+};
+
+// payload size of each message type, indexed by MsgType
+const std::uint8_t MSG_PAYLOAD[MSG_TYPE_COUNT] = { 0, 2, 4, 3, 2, 1, 1, 1 };
+
+inline std::size_t msgSize(MsgType t) { return MSG_HEADER + MSG_PAYLOAD[t]; }
+
+// append one message to an outgoing buffer
+inline void writeMsg(std::vector<std::uint8_t>& out, MsgType t, std::uint8_t a = 0, std::uint8_t b = 0, std::uint8_t c = 0, std::uint8_t d = 0) {
+    std::uint16_t len = (std::uint16_t)msgSize(t);
+    std::uint8_t fields[4] = { a, b, c, d };
+    out.push_back(len & 0xFF);
+    out.push_back(len >> 8);
+    out.push_back(PROTO_VERSION);
+    out.push_back(t);
+    out.insert(out.end(), fields, fields + MSG_PAYLOAD[t]);
+}
+
+inline void writeRoll(std::vector<std::uint8_t>& out, int player, int value) { writeMsg(out, MSG_ROLL, player, value); }
+// steps are stored as signed bytes so -1 (home base) round-trips
+inline void writeMove(std::vector<std::uint8_t>& out, int player, int token, int from, int to) { writeMsg(out, MSG_MOVE, player, token, (std::uint8_t)(std::int8_t)from, (std::uint8_t)(std::int8_t)to); }
+inline void writeCapture(std::vector<std::uint8_t>& out, int player, int victim, int token) { writeMsg(out, MSG_CAPTURE, player, victim, token); }
+inline void writeFinish(std::vector<std::uint8_t>& out, int player, int rank) { writeMsg(out, MSG_FINISH, player, rank); }
+inline void writeForfeit(std::vector<std::uint8_t>& out, int player) { writeMsg(out, MSG_FORFEIT, player); }
+inline void writeTurn(std::vector<std::uint8_t>& out, int player) { writeMsg(out, MSG_TURN, player); }
+inline void writeSeats(std::vector<std::uint8_t>& out, int botMask) { writeMsg(out, MSG_SEATS, botMask); }
+
+// read-only view of one message, pointing straight into the receive buffer
+struct MsgView {
+    const std::uint8_t* data = nullptr;
+
+    MsgType type() const { return (MsgType)data[3]; }
+    std::uint16_t size() const { return (std::uint16_t)(data[0] | (data[1] << 8)); }
+    int u8(int field) const { return data[MSG_HEADER + field]; }
+    int s8(int field) const { return (std::int8_t)data[MSG_HEADER + field]; }
+
+    int player() const { return u8(0); }
+    // MSG_ROLL
+    int value() const { return u8(1); }
+    // MSG_MOVE
+    int token() const { return u8(1); }
+    int from() const { return s8(2); }
+    int to() const { return s8(3); }
+    // MSG_CAPTURE
+    int victim() const { return u8(1); }
+    int victimToken() const { return u8(2); }
+    // MSG_FINISH
+    int rank() const { return u8(1); }
+    // MSG_SEATS, bit i set when player i is a bot
+    int botMask() const { return u8(0); }
+};
+
+enum ParseResult { PARSE_OK, PARSE_INCOMPLETE, PARSE_BAD };
+
+// parse the message at the front of buf without copying it.
+// on PARSE_OK, msg points into buf and msg.size() bytes can be consumed.
+inline ParseResult parseMsg(const std::uint8_t* buf, std::size_t n, MsgView& msg) {
+    if(n < MSG_HEADER) return PARSE_INCOMPLETE;
+    std::uint16_t len = (std::uint16_t)(buf[0] | (buf[1] << 8));
+    std::uint8_t type = buf[3];
+    if(buf[2] != PROTO_VERSION) return PARSE_BAD;
+    if(type == 0 || type >= MSG_TYPE_COUNT) return PARSE_BAD;
+    if(len != msgSize((MsgType)type)) return PARSE_BAD;
+    if(n < len) return PARSE_INCOMPLETE;
+    msg.data = buf;
+    return PARSE_OK;
+}
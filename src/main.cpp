@@ -7,6 +7,11 @@
 #include <ctime>
 #include <algorithm>
 #include <memory>
+#include <fstream>
+#include <cstdio>
+#include <functional>
+#include <utility>
+#include "Protocol.hpp"
 
 // window and layout constants
 const int WIN_W = 1920;
@@ -16,7 +21,27 @@ const float BOARD_W = 15 * CELL;
 const float UI_W = 500.0f;
 const float OFF_X = (WIN_W - UI_W - BOARD_W) / 2.0f;
 const float OFF_Y = (WIN_H - BOARD_W) / 2.0f;
-const float ANIM_TIME = 0.59f;
+const float ANIM_TIME = 0.59f;         // per square, at normal speed
+const float TURBO_MOVE_TIME = 0.35f;   // whole move, at turbo speed
+
+// animation speeds, selectable with T
+enum AnimSpeed { SPEED_NORMAL, SPEED_TURBO, SPEED_INSTANT, SPEED_COUNT };
+const char* const SPEED_NAMES[SPEED_COUNT] = { "NORMAL", "TURBO", "INSTANT" };
+const float SPEED_ROLL_TIME[SPEED_COUNT]    = { 0.5f, 0.2f, 0 };
+const float SPEED_CAPTURE_TIME[SPEED_COUNT] = { 0.45f, 0.25f, 0 }; // captured token flying home
+const float SPEED_BOT_THINK[SPEED_COUNT]    = { 0.6f, 0.3f, 0.1f }; // pause before each bot action
+const int FRAME_LIMIT = 60;           // 0 leaves the frame rate uncapped
+const float SIM_DT = 1.0f / 60;       // fixed simulation step for menu and particle effects
+const float MAX_FRAME_DT = 0.25f;     // longest frame simulated, so a stall cannot snowball
+const float AUTO_ROLL_TIME = 15.0f;   // idle seconds before a bot plays the turn
+const int AFK_TURN_LIMIT = 3;         // idle turns in a row before the player forfeits
+const bool ON_DEMAND_RENDER = true;   // stop redrawing while nothing on screen moves
+const float PULSE_TIME = 4.0f;        // seconds highlights pulse after the last activity
+const float JOURNAL_FLUSH_TIME = 0.25f; // max delay before logged moves hit disk
+#ifndef LUDO_JOURNAL_FILE
+#define LUDO_JOURNAL_FILE "match.journal" // tests point this at a scratch file
+#endif
+const char* const JOURNAL_FILE = LUDO_JOURNAL_FILE;
 
 // color palette
 const sf::Color C_BG      = sf::Color(26, 26, 46);
@@ -34,9 +59,17 @@ const sf::Color C_GOLD    = sf::Color(255, 215, 0);
 const int PX[52] = { 1,2,3,4,5, 6,6,6,6,6, 6, 7,8, 8,8,8,8,8, 9,10,11,12,13,14, 14,14, 13,12,11,10,9, 8,8,8,8,8, 8, 7,6, 6,6,6,6,6, 5,4,3,2,1,0, 0,0 };
 const int PY[52] = { 6,6,6,6,6, 5,4,3,2,1, 0, 0,0, 1,2,3,4,5, 6,6,6,6,6,6, 7,8, 8,8,8,8,8, 9,10,11,12,13, 14, 14,14, 13,12,11,10,9, 8,8,8,8,8,8, 7,6 };
 
+// sprite atlas layout: four tokens and the star in a row, center below
+const int ATLAS_SLOT = 128;
+const int ATLAS_PAD = 2;
+const int ATLAS_CENTER = 3 * ATLAS_SLOT;
+const int ATLAS_W = 5 * (ATLAS_SLOT + 2*ATLAS_PAD);
+const int ATLAS_H = (ATLAS_SLOT + 2*ATLAS_PAD) + (ATLAS_CENTER + 2*ATLAS_PAD);
+
 // resource manager
 struct Assets {
-    sf::Texture tRed, tGreen, tYel, tBlue, tStar, tCenter;
+    sf::Texture atlas;            // every sprite, packed at load time
+    sf::IntRect rToken[4], rStar, rCenter;
     sf::SoundBuffer bRoll, bMove, bKill, bWin;
     sf::Sound sRoll, sMove, sKill, sWin;
     sf::Font fontBold, fontReg;
@@ -44,16 +77,10 @@ struct Assets {
 
     void load() {
         hasImages = true;
-        if(!tRed.loadFromFile("Sprites/red.png")) hasImages = false;
-        if(!tGreen.loadFromFile("Sprites/green.png")) hasImages = false;
-        if(!tYel.loadFromFile("Sprites/yellow.png")) hasImages = false;
-        if(!tBlue.loadFromFile("Sprites/blue.png")) hasImages = false;
-        if(!tStar.loadFromFile("Sprites/star.png")) hasImages = false;
-        if(!tCenter.loadFromFile("Sprites/center.png")) hasImages = false;
-
-        tRed.setSmooth(true); tGreen.setSmooth(true);
-        tYel.setSmooth(true); tBlue.setSmooth(true);
-        tStar.setSmooth(true); tCenter.setSmooth(true);
+        const char* files[6] = {"Sprites/red.png", "Sprites/green.png", "Sprites/yellow.png", "Sprites/blue.png", "Sprites/star.png", "Sprites/center.png"};
+        sf::Texture src[6];
+        for(int i=0; i<6; i++) if(!src[i].loadFromFile(files[i])) hasImages = false;
+        if(hasImages) packAtlas(src);
 
         if(bRoll.loadFromFile("Audios/roll.wav")) sRoll.setBuffer(bRoll);
         if(bMove.loadFromFile("Audios/move.wav")) sMove.setBuffer(bMove);
@@ -68,6 +95,60 @@ struct Assets {
         for(const auto& p : paths2) if(fontReg.loadFromFile(p)) { reg=true; break; }
         if(!reg) fontReg = fontBold;
     }
+
+    // draw each sprite into its atlas slot, downscaled to roughly the size it is shown at
+    void packAtlas(sf::Texture* src) {
+        for(int i=0; i<5; i++) {
+            sf::IntRect r(ATLAS_PAD + i*(ATLAS_SLOT + 2*ATLAS_PAD), ATLAS_PAD, ATLAS_SLOT, ATLAS_SLOT);
+            if(i < 4) rToken[i] = r; else rStar = r;
+        }
+        rCenter = sf::IntRect(ATLAS_PAD, ATLAS_SLOT + 3*ATLAS_PAD, ATLAS_CENTER, ATLAS_CENTER);
+
+        sf::RenderTexture rt;
+        if(!rt.create(ATLAS_W, ATLAS_H)) { hasImages = false; return; }
+        rt.clear(sf::Color::Transparent);
+        for(int i=0; i<6; i++) {
+            sf::IntRect r = i < 4 ? rToken[i] : (i == 4 ? rStar : rCenter);
+            sf::Vector2f sz(src[i].getSize());
+            src[i].setSmooth(true);
+            src[i].generateMipmap();
+            sf::Sprite s(src[i]);
+            if(i < 4) {
+                // tokens keep their aspect ratio, centered in the slot
+                float k = r.width / std::max(sz.x, sz.y);
+                s.setScale(k, k);
+                s.setPosition(r.left + (r.width - sz.x*k)/2, r.top + (r.height - sz.y*k)/2);
+            } else {
+                s.setScale(r.width / sz.x, r.height / sz.y);
+                s.setPosition(r.left, r.top);
+            }
+            rt.draw(s, sf::BlendNone);
+        }
+        rt.display();
+        atlas.loadFromImage(rt.getTexture().copyToImage());
+        atlas.setSmooth(true);
+    }
+};
+
+// collects textured quads from one texture and draws them in a single call
+class SpriteBatch {
+    sf::VertexArray quads;
+    const sf::Texture* texture = nullptr;
+public:
+    SpriteBatch() : quads(sf::Quads) {}
+    void begin(const sf::Texture& tex) { texture = &tex; quads.clear(); }
+    // src drawn centered on pos, uniformly scaled
+    void add(sf::IntRect src, sf::Vector2f pos, float scale, sf::Color tint) {
+        float hw = src.width * scale / 2, hh = src.height * scale / 2;
+        float l = src.left, t = src.top, r = l + src.width, b = t + src.height;
+        quads.append(sf::Vertex({pos.x - hw, pos.y - hh}, tint, {l, t}));
+        quads.append(sf::Vertex({pos.x + hw, pos.y - hh}, tint, {r, t}));
+        quads.append(sf::Vertex({pos.x + hw, pos.y + hh}, tint, {r, b}));
+        quads.append(sf::Vertex({pos.x - hw, pos.y + hh}, tint, {l, b}));
+    }
+    void draw(sf::RenderTarget& target) {
+        if(quads.getVertexCount() > 0) target.draw(quads, texture);
+    }
 };
 
 // convert grid to screen pixels
@@ -106,7 +187,7 @@ sf::Vector2f getStepPos(int pId, int step, int tokenIndex = 0) {
     return sf::Vector2f(OFF_X + col*CELL + CELL/2, OFF_Y + row*CELL + CELL/2);
 }
 
-// clickable ui button
+// clickable ui button; the hover pulse is a draw transform, the shapes never change
 class Button {
     sf::RectangleShape bg;
     sf::Text label;
@@ -116,7 +197,8 @@ public:
     Button() {}
     void setup(sf::Font& font, std::string text, float x, float y, float w, float h, sf::Color col) {
         bg.setSize({w, h});
-        bg.setPosition(x, y);
+        bg.setOrigin(w/2, h/2);
+        bg.setPosition(x + w/2, y + h/2);
         bg.setFillColor(col);
         bg.setOutlineThickness(3);
         bg.setOutlineColor(C_WHITE);
@@ -133,28 +215,18 @@ public:
         return bg.getGlobalBounds().contains((float)mouse.x, (float)mouse.y);
     }
     void update(sf::Vector2i mouse) {
-        hovered = contains(mouse);
+        bool h = contains(mouse);
+        if(h != hovered) bg.setOutlineColor(h ? C_GOLD : C_WHITE);
+        hovered = h;
     }
     void draw(sf::RenderWindow& w) {
-        float scale = hovered ? 1.05f + 0.03f * sin(hoverClock.getElapsedTime().asSeconds() * 8) : 1.0f;
-        sf::Vector2f pos = bg.getPosition();
-        sf::Vector2f size = bg.getSize();
-        bg.setOrigin(size.x/2, size.y/2);
-        bg.setPosition(pos.x + size.x/2, pos.y + size.y/2);
-        bg.setScale(scale, scale);
-        
-        sf::Color outline = hovered ? C_GOLD : C_WHITE;
-        bg.setOutlineColor(outline);
-        
-        w.draw(bg);
-        
-        label.setScale(scale, scale);
-        w.draw(label);
-        
-        bg.setOrigin(0, 0);
-        bg.setPosition(pos);
-        bg.setScale(1, 1);
-        label.setScale(1, 1);
+        sf::RenderStates states;
+        if(hovered) {
+            float scale = 1.05f + 0.03f * sin(hoverClock.getElapsedTime().asSeconds() * 8);
+            states.transform.scale(scale, scale, bg.getPosition().x, bg.getPosition().y);
+        }
+        w.draw(bg, states);
+        w.draw(label, states);
     }
 };
 
@@ -226,31 +298,118 @@ public:
     bool isSafe() const override { return true; }
 };
 
+// tween engine: every running animation lives in one fixed pool.
+// a tween walks *pos through up to MAX_PATH waypoints, one hop per segment,
+// calling onStep as each segment starts and onDone at the end. a spline
+// tween instead glides through every waypoint in a single segment. with no
+// waypoints it is just a timer, which is how sequences are chained.
+const int MAX_TWEENS = 64;
+const int MAX_PATH = 8;
+enum Ease { EASE_LINEAR, EASE_OUT_QUAD, EASE_IN_OUT };
+
+// catmull-rom curve through all n points, u in [0, 1]
+sf::Vector2f splinePoint(const sf::Vector2f* p, int n, float u) {
+    float f = u * (n - 1);
+    int i = std::min((int)f, n - 2);
+    float t = f - i, t2 = t*t, t3 = t2*t;
+    sf::Vector2f p0 = p[std::max(i-1, 0)], p1 = p[i], p2 = p[i+1], p3 = p[std::min(i+2, n-1)];
+    return 0.5f * (2.0f*p1 + (p2 - p0)*t + (2.0f*p0 - 5.0f*p1 + 4.0f*p2 - p3)*t2 + (3.0f*p1 - p0 - 3.0f*p2 + p3)*t3);
+}
+
+float applyEase(Ease e, float u) {
+    if(e == EASE_OUT_QUAD) return 1 - (1-u)*(1-u);
+    if(e == EASE_IN_OUT) return u*u*(3 - 2*u);
+    return u;
+}
+
+struct Tween {
+    bool alive = false, fresh = false, spline = false;
+    float t = 0, segTime = 0, hopHeight = 0;
+    Ease ease = EASE_LINEAR;
+    sf::Vector2f path[MAX_PATH];
+    int points = 0, seg = -1;
+    sf::Vector2f* pos = nullptr;
+    float* hop = nullptr;
+    std::function<void()> onStep, onDone;
+};
+
+class TweenPool {
+    Tween pool[MAX_TWEENS];
+    int active = 0;
+    bool updating = false;
+public:
+    // returns nullptr when the pool is full, callers then skip straight to the end state
+    Tween* add(float duration, float delay = 0) {
+        for(auto& tw : pool) {
+            if(tw.alive) continue;
+            tw = Tween();
+            tw.alive = true;
+            tw.fresh = updating; // started from a callback, so it begins next frame
+            tw.t = -delay;
+            tw.segTime = duration;
+            active++;
+            return &tw;
+        }
+        return nullptr;
+    }
+    int count() const { return active; }
+    void clear() { for(auto& tw : pool) tw = Tween(); active = 0; }
+
+    void update(float dt) {
+        updating = true;
+        for(auto& tw : pool) {
+            if(!tw.alive || tw.fresh) continue;
+            tw.t += dt;
+            if(tw.t < 0) continue;
+
+            int segs = tw.spline ? 1 : std::max(1, tw.points - 1);
+            float total = tw.segTime * segs;
+            float tt = std::min(tw.t, total);
+            int seg = tw.segTime > 0 ? std::min((int)(tt / tw.segTime), segs - 1) : segs - 1;
+            while(tw.seg < seg) { tw.seg++; if(tw.onStep) tw.onStep(); }
+
+            float u = tw.segTime > 0 ? std::min(1.0f, (tt - seg * tw.segTime) / tw.segTime) : 1;
+            if(tw.pos && tw.points >= 2) {
+                if(tw.spline) *tw.pos = splinePoint(tw.path, tw.points, applyEase(tw.ease, u));
+                else *tw.pos = tw.path[seg] + (tw.path[seg+1] - tw.path[seg]) * applyEase(tw.ease, u);
+            }
+            if(tw.hop) *tw.hop = sin(u * 3.14159f) * tw.hopHeight;
+
+            if(tw.t >= total) {
+                // onDone may start new tweens, possibly in this slot
+                std::function<void()> done = std::move(tw.onDone);
+                tw = Tween();
+                active--;
+                if(done) done();
+            }
+        }
+        for(auto& tw : pool) tw.fresh = false;
+        updating = false;
+    }
+};
+
 class Token {
 public:
-    sf::Sprite sp;
+    sf::IntRect texRect;
+    float scale = 1;
     sf::CircleShape fallback;
     int id, pId, steps = -1;
     bool active = false, finished = false;
+    bool tweening = false;        // drawn at drawPos/lift instead of its square
+    sf::Vector2f drawPos;
+    float lift = 0;
     
-    Token(int i, int pid, sf::Texture& tex, bool hasImg, sf::Color c) : id(i), pId(pid) {
-        if(hasImg) {
-            sp.setTexture(tex);
-            sf::Vector2u sz = tex.getSize();
-            float scale = (CELL * 0.85f) / sz.x; 
-            sp.setScale(scale, scale);
-            sp.setOrigin(sz.x/2.0f, sz.y/2.0f);
-        }
+    Token(int i, int pid, sf::IntRect rect, sf::Color c) : texRect(rect), id(i), pId(pid) {
+        if(rect.width > 0) scale = (CELL * 0.85f) / rect.width;
         fallback.setRadius(CELL*0.35f); fallback.setOrigin(CELL*0.35f, CELL*0.35f);
         fallback.setFillColor(c); fallback.setOutlineThickness(3); fallback.setOutlineColor(C_WHITE);
     }
 
-    void draw(sf::RenderWindow& w, sf::Vector2f pos, float yOffset, bool useImg, bool greyed) {
+    // sprites are queued on the batch, the shape fallback draws directly
+    void draw(SpriteBatch& batch, sf::RenderWindow& w, sf::Vector2f pos, float yOffset, bool useImg, bool greyed) {
         sf::Color tint = greyed ? sf::Color(100,100,100, 150) : sf::Color::White;
         if(useImg) {
-            sp.setPosition(pos.x, pos.y - yOffset);
-            sp.setColor(tint);
-            w.draw(sp);
+            batch.add(texRect, sf::Vector2f(pos.x, pos.y - yOffset), scale, tint);
         } else {
             fallback.setPosition(pos.x, pos.y - yOffset);
             fallback.setFillColor(greyed ? sf::Color(80,80,80) : fallback.getFillColor());
@@ -259,16 +418,24 @@ public:
     }
 };
 
-// menu background animation
-struct MenuBubble { sf::Vector2f pos, vel; float radius; sf::Color col; };
+// menu background animation, all bubbles drawn as one triangle batch
+const int BUBBLE_SEGMENTS = 30;
+struct MenuBubble { sf::Vector2f pos, prev, vel; float radius; sf::Color col; };
 class MenuSystem {
     std::vector<MenuBubble> bubbles;
+    sf::Vector2f unitCircle[BUBBLE_SEGMENTS + 1];
+    sf::VertexArray tris;
 public:
-    MenuSystem() {
-        for(int i=0; i<35; i++) {
+    MenuSystem(int count = 35) : tris(sf::Triangles) {
+        for(int i=0; i<=BUBBLE_SEGMENTS; i++) {
+            float a = i * 2 * 3.14159265f / BUBBLE_SEGMENTS;
+            unitCircle[i] = sf::Vector2f(cos(a), sin(a));
+        }
+        for(int i=0; i<count; i++) {
             MenuBubble b;
             b.pos = sf::Vector2f(rand()%WIN_W, rand()%WIN_H);
-            b.vel = sf::Vector2f((rand()%10-5)/4.0f, (rand()%10-5)/4.0f);
+            b.prev = b.pos;
+            b.vel = sf::Vector2f((rand()%10-5)*15.0f, (rand()%10-5)*15.0f); // px/s
             b.radius = rand()%60 + 20;
             int c = rand()%4;
             if(c==0) b.col = sf::Color(229,57,53, 40); else if(c==1) b.col = sf::Color(67,160,71, 40);
@@ -276,18 +443,29 @@ public:
             bubbles.push_back(b);
         }
     }
-    void update() {
+    void update(float dt) {
         for(auto& b : bubbles) {
-            b.pos += b.vel;
+            b.prev = b.pos;
+            b.pos += b.vel * dt;
             if(b.pos.x < -100 || b.pos.x > WIN_W+100) b.vel.x *= -1;
             if(b.pos.y < -100 || b.pos.y > WIN_H+100) b.vel.y *= -1;
         }
     }
-    void draw(sf::RenderWindow& w) {
+    // alpha blends between the last two simulation steps
+    void draw(sf::RenderWindow& w, float alpha) {
+        if(bubbles.empty()) return;
+        tris.resize(bubbles.size() * BUBBLE_SEGMENTS * 3);
+        sf::Vertex* v = &tris[0];
         for(auto& b : bubbles) {
-            sf::CircleShape s(b.radius); s.setOrigin(b.radius, b.radius);
-            s.setPosition(b.pos); s.setFillColor(b.col); w.draw(s);
+            sf::Vector2f pos = b.prev + (b.pos - b.prev) * alpha;
+            for(int i=0; i<BUBBLE_SEGMENTS; i++, v += 3) {
+                v[0].position = pos;
+                v[1].position = pos + unitCircle[i] * b.radius;
+                v[2].position = pos + unitCircle[i+1] * b.radius;
+                v[0].color = v[1].color = v[2].color = b.col;
+            }
         }
+        w.draw(tris);
     }
 };
 
@@ -300,47 +478,87 @@ struct Player {
     bool killed = false;
     bool finished = false;
     bool forfeited = false;
+    bool bot = false;
+    int afkTurns = 0;
     int finalRank = 0;
     int captureCount = 0;
 };
 
-// particle effects
-struct Particle { sf::Vector2f position; sf::Vector2f velocity; float life; sf::Color color; };
+// particle effects, pooled as structure-of-arrays.
+// live particles are kept packed in [0, count) so update and draw only touch them.
+const int MAX_PARTICLES = 100000;
+const float PARTICLE_SIZE = 8.0f;
+const float PARTICLE_GRAVITY = 720.0f; // px/s^2
+const float PARTICLE_FADE = 180.0f;    // alpha lost per second
 class FireworkSystem {
-    std::vector<Particle> particles;
+    std::vector<float> px, py, vx, vy, life;
+    std::vector<float> ppx, ppy; // positions at the previous step, for interpolation
+    std::vector<sf::Color> color;
+    int count = 0;
+    sf::VertexArray quads;
 public:
+    FireworkSystem() : px(MAX_PARTICLES), py(MAX_PARTICLES), vx(MAX_PARTICLES), vy(MAX_PARTICLES),
+                       life(MAX_PARTICLES), ppx(MAX_PARTICLES), ppy(MAX_PARTICLES), color(MAX_PARTICLES), quads(sf::Quads) {}
+
     void explode(float x, float y, sf::Color c) {
-        for(int i=0; i<60; i++) {
-            Particle p; p.position = sf::Vector2f(x, y);
-            float angle = (rand() % 360) * 3.14159 / 180;
-            float speed = (rand() % 80 + 30) / 10.0f;
-            p.velocity = sf::Vector2f(cos(angle)*speed, sin(angle)*speed);
-            p.life = 255; p.color = c; particles.push_back(p);
+        for(int i=0; i<60 && count < MAX_PARTICLES; i++, count++) {
+            float angle = (rand() % 360) * 3.14159f / 180;
+            float speed = (rand() % 80 + 30) * 6.0f; // px/s
+            px[count] = ppx[count] = x; py[count] = ppy[count] = y;
+            vx[count] = cos(angle)*speed; vy[count] = sin(angle)*speed;
+            life[count] = 255; color[count] = c;
         }
     }
-    void update() {
-        for(auto& p : particles) { p.position += p.velocity; p.life -= 3; p.velocity.y += 0.2f; }
-        particles.erase(std::remove_if(particles.begin(), particles.end(), [](const Particle& p){ return p.life <= 0; }), particles.end());
+    void update(float dt) {
+        for(int i=0; i<count; ) {
+            life[i] -= PARTICLE_FADE * dt;
+            if(life[i] <= 0) {
+                // move the last live particle into this slot
+                count--;
+                px[i] = px[count]; py[i] = py[count];
+                ppx[i] = ppx[count]; ppy[i] = ppy[count];
+                vx[i] = vx[count]; vy[i] = vy[count];
+                life[i] = life[count]; color[i] = color[count];
+                continue;
+            }
+            vy[i] += PARTICLE_GRAVITY * dt;
+            ppx[i] = px[i]; ppy[i] = py[i];
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            i++;
+        }
     }
-    void draw(sf::RenderWindow& win) {
-        for(auto& p : particles) {
-            sf::CircleShape dot(4); dot.setPosition(p.position);
-            dot.setFillColor(sf::Color(p.color.r, p.color.g, p.color.b, (sf::Uint8)p.life));
-            win.draw(dot);
+    void draw(sf::RenderWindow& win, float alpha) {
+        quads.resize(count * 4);
+        for(int i=0; i<count; i++) {
+            sf::Color c = color[i]; c.a = (sf::Uint8)life[i];
+            float x = ppx[i] + (px[i] - ppx[i]) * alpha;
+            float y = ppy[i] + (py[i] - ppy[i]) * alpha;
+            sf::Vertex* q = &quads[i * 4];
+            q[0].position = sf::Vector2f(x, y);
+            q[1].position = sf::Vector2f(x + PARTICLE_SIZE, y);
+            q[2].position = sf::Vector2f(x + PARTICLE_SIZE, y + PARTICLE_SIZE);
+            q[3].position = sf::Vector2f(x, y + PARTICLE_SIZE);
+            q[0].color = q[1].color = q[2].color = q[3].color = c;
         }
+        win.draw(quads);
     }
 };
 
 enum State { MENU, PLAYING, ROLLING_DICE, GAME_OVER };
 
 class Game {
+    friend struct GameTest;
     sf::RenderWindow win;
     Assets assets; 
     VisualDice visualDice; 
     FireworkSystem fireworks;
     sf::RectangleShape grid[15][15];
     sf::Sprite sStar, sCenter;
+    SpriteBatch tokenBatch;
     sf::ConvexShape fallbackStar;
+    sf::RenderTexture boardTex; // grid, stars and center baked once
+    sf::Sprite boardSprite;
     MenuSystem menuAnim;
     
     std::vector<std::unique_ptr<Tile>> trackTiles;
@@ -348,33 +566,43 @@ class Game {
     
     std::vector<Player> players;
     std::vector<std::string> rankList; 
+    std::vector<std::uint8_t> matchLog; // turn deltas in wire format
+    std::ofstream journal;              // on-disk copy of matchLog for crash recovery
+    std::size_t journaled = 0;          // bytes of matchLog already written
+    sf::Clock journalClock;
     
     State state = MENU;
     int curP = 0, roll = 1;
     bool rolled = false, anim = false;
-    sf::Clock rollClock;
+    TweenPool tweens;
+    AnimSpeed animSpeed = SPEED_NORMAL;
+    sf::Clock idleClock; // time since current player's last input
+    sf::Clock botClock;  // time since the last bot action
+    bool idleTakeover = false;
     
     Token* movingT = nullptr;
-    int movesLeft = 0;
-    sf::Clock clk;
-    sf::Vector2f animStart, animEnd;
+    int moveFrom = -1;
 
-    sf::Text txtInfo, txtTurn, txtTitle, txtSub, txtLeaderboard, txtControls, txtRankLabel, txtTitleShadow, txtLeaderboardTitle; 
-    sf::Text txtMenuOptions, txtHelp;
+    sf::Text txtInfo, txtTurn, txtTitle, txtSub, txtLeaderboard, txtControls, txtTitleShadow, txtLeaderboardTitle; 
+    sf::Text txtMenuOptions, txtHelp, txtSeats;
     sf::Clock textPulseClock;
+    sf::Clock activityClock; // time since the last input or state change
     sf::RectangleShape leaderboardBox, uiPanel, turnHighlighter, overlay;
     sf::RectangleShape helpOverlay;
 
     bool showHelp = false;
     Button btnStart, btnHelp, btnQuit, btnRestart;
     sf::CircleShape playerIndicators[4];
+    sf::CircleShape indicatorGlow; // disc behind the current player's indicator, pulsed by scaling
     sf::Text playerLabels[4];
     sf::Text captureCounters[4];
+    sf::Text txtRankLabels[4];
+    bool panelDirty = true; // panel text needs layout before the next draw
 
 public:
     Game() : win(sf::VideoMode(WIN_W, WIN_H), "Ludo Legends", sf::Style::Close | sf::Style::Resize) {        
         std::srand(static_cast<unsigned>(std::time(nullptr)));
-        win.setFramerateLimit(60);
+        win.setFramerateLimit(FRAME_LIMIT);
         assets.load(); 
 
         // setup board grid
@@ -399,23 +627,23 @@ public:
             grid[r][c].setFillColor(col);
         }
 
-        sStar.setTexture(assets.tStar);
-        sf::Vector2u stSz = assets.tStar.getSize();
-        if(stSz.x > 0) sStar.setScale(CELL/stSz.x, CELL/stSz.y);
+        sStar.setTexture(assets.atlas);
+        sStar.setTextureRect(assets.rStar);
+        if(assets.rStar.width > 0) sStar.setScale(CELL/assets.rStar.width, CELL/assets.rStar.height);
 
         fallbackStar.setPointCount(5);
         fallbackStar.setPoint(0,{0,-10}); fallbackStar.setPoint(1,{3,-3}); fallbackStar.setPoint(2,{10,-3});
         fallbackStar.setPoint(3,{5,2}); fallbackStar.setPoint(4,{7,10}); fallbackStar.setFillColor(sf::Color(100,100,100,150));
 
-        sCenter.setTexture(assets.tCenter);
-        sf::Vector2u cnSz = assets.tCenter.getSize();
-        if(cnSz.x > 0) sCenter.setScale((3*CELL)/cnSz.x, (3*CELL)/cnSz.y);
+        sCenter.setTexture(assets.atlas);
+        sCenter.setTextureRect(assets.rCenter);
+        if(assets.rCenter.width > 0) sCenter.setScale((3*CELL)/assets.rCenter.width, (3*CELL)/assets.rCenter.height);
         sCenter.setPosition(getGridPos(6,6));
 
-        setupP(0, "RED", C_RED, assets.tRed);
-        setupP(1, "GREEN", C_GREEN, assets.tGreen);
-        setupP(2, "YELLOW", C_YELLOW, assets.tYel);
-        setupP(3, "BLUE", C_BLUE, assets.tBlue);
+        setupP(0, "RED", C_RED);
+        setupP(1, "GREEN", C_GREEN);
+        setupP(2, "YELLOW", C_YELLOW);
+        setupP(3, "BLUE", C_BLUE);
 
         turnHighlighter.setSize({6*CELL, 6*CELL});
         turnHighlighter.setFillColor(sf::Color::Transparent);
@@ -460,10 +688,11 @@ public:
         txtLeaderboard.setFont(assets.fontReg); txtLeaderboard.setCharacterSize(45); txtLeaderboard.setFillColor(C_WHITE);
         txtLeaderboard.setLetterSpacing(1.2f);
 
-        txtRankLabel.setFont(assets.fontBold); txtRankLabel.setCharacterSize(36); txtRankLabel.setOutlineThickness(3); txtRankLabel.setOutlineColor(sf::Color::Black); 
+        for(auto& t : txtRankLabels) {
+            t.setFont(assets.fontBold); t.setCharacterSize(36); t.setOutlineThickness(3); t.setOutlineColor(sf::Color::Black); t.setFillColor(C_WHITE);
+        }
 
         txtControls.setFont(assets.fontReg); txtControls.setCharacterSize(20); txtControls.setPosition(panelCenter - 100, 900);
-        txtControls.setString("CONTROLS\n\nSpace : Roll Dice\nF : Forfeit Game");
         txtControls.setFillColor(sf::Color(150,150,150));
         
         overlay.setSize({(float)WIN_W, (float)WIN_H});
@@ -480,7 +709,9 @@ public:
             "- Click a valid token to move.\n"
             "- Roll a 6 to enter from home.\n"
             "- Capture an enemy to unlock home stretch.\n"
-            "- Finish all 4 tokens to rank.\n\n"
+            "- Finish all 4 tokens to rank.\n"
+            "- Press 1-4 in the menu to make a seat a CPU player.\n"
+            "- Press T to switch animation speed.\n\n"
             "Press H to close this help."
         );
         sf::FloatRect hb = txtHelp.getLocalBounds();
@@ -492,6 +723,10 @@ public:
         btnQuit.setup(assets.fontBold, "QUIT", WIN_W/2 - 150, 660, 300, 60, C_RED);
         btnRestart.setup(assets.fontBold, "PLAY AGAIN", WIN_W/2 - 150, WIN_H - 150, 300, 60, C_GREEN);
 
+        txtSeats.setFont(assets.fontReg);
+        txtSeats.setCharacterSize(22);
+        txtSeats.setFillColor(C_TEXT);
+
         float indicatorStartY = 530;
         float indicatorX = WIN_W - UI_W + 200;
         for(int i=0; i<4; i++) {
@@ -512,7 +747,38 @@ public:
             captureCounters[i].setFillColor(sf::Color(180,180,180));
         }
 
+        indicatorGlow.setRadius(25 + 8);
+        indicatorGlow.setOrigin(25 + 8, 25 + 8);
+
         initTrackTiles();
+        buildBoard();
+        recoverJournal();
+    }
+
+    // pre-render the static board so each frame draws it with one call.
+    // the texture follows the window's pixel density, so rebuild on resize.
+    void buildBoard() {
+        const float pad = 2; // room for the cell outlines
+        sf::Vector2u ws = win.getSize();
+        float scale = std::max(1.0f, std::max(ws.x / (float)WIN_W, ws.y / (float)WIN_H));
+        unsigned px = (unsigned)std::ceil((BOARD_W + 2*pad) * scale);
+        if(!boardTex.create(px, px)) return;
+        boardTex.setSmooth(true);
+        boardTex.setView(sf::View(sf::FloatRect(OFF_X - pad, OFF_Y - pad, BOARD_W + 2*pad, BOARD_W + 2*pad)));
+
+        boardTex.clear(sf::Color::Transparent);
+        for(int r=0;r<15;r++) for(int c=0;c<15;c++) boardTex.draw(grid[r][c]);
+        int starPos[8][2] = {{1,6}, {6,2}, {8,1}, {12,6}, {13,8}, {8,12}, {6,13}, {2,8}};
+        for(auto& pos : starPos) {
+            if(assets.hasImages) { sStar.setPosition(getGridPos(pos[0],pos[1])); boardTex.draw(sStar); }
+            else { fallbackStar.setPosition(getGridPos(pos[0],pos[1])+sf::Vector2f(20,18)); boardTex.draw(fallbackStar); }
+        }
+        if(assets.hasImages) boardTex.draw(sCenter);
+        boardTex.display();
+
+        boardSprite.setTexture(boardTex.getTexture(), true);
+        boardSprite.setPosition(OFF_X - pad, OFF_Y - pad);
+        boardSprite.setScale(1/scale, 1/scale);
     }
 
     // initialize track tiles with safe zones
@@ -525,27 +791,45 @@ public:
     }
 
     // setup player with 4 tokens in home base
-    void setupP(int id, std::string n, sf::Color c, sf::Texture& t) {
+    void setupP(int id, std::string n, sf::Color c) {
         Player p = {id, n, c};
-        for(int i=0; i<4; i++) p.tokens.emplace_back(i, id, t, assets.hasImages, c);
+        for(int i=0; i<4; i++) p.tokens.emplace_back(i, id, assets.rToken[id], c);
         players.push_back(p);
     }
 
     void run() {
+        sf::Clock frameClock;
+        float simTime = 0;
         while(win.isOpen()) {
+            float dt = std::min(frameClock.restart().asSeconds(), MAX_FRAME_DT);
             sf::Event e;
-            while(win.pollEvent(e)) {
+            bool idle = ON_DEMAND_RENDER && !isAnimating();
+            bool waited = idle && waitEvent(e, nextWake());
+            if(idle) frameClock.restart(); // time spent waiting is not animation time
+            while(waited || win.pollEvent(e)) {
+                waited = false;
+                activityClock.restart();
                 if(e.type == sf::Event::Closed) win.close();
+                if(e.type == sf::Event::Resized) buildBoard();
+                if(e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::T) {
+                    animSpeed = (AnimSpeed)((animSpeed + 1) % SPEED_COUNT);
+                    updateMenuText();
+                }
                 
                 if(state == MENU && e.type == sf::Event::KeyPressed) {
-                    if(e.key.code == sf::Keyboard::Enter) { state = PLAYING; updateUI("Space to Roll"); assets.sWin.play(); }
+                    if(e.key.code == sf::Keyboard::Enter) startMatch();
                     if(e.key.code == sf::Keyboard::H) { showHelp = !showHelp; }
                     if(e.key.code == sf::Keyboard::Escape) { win.close(); }
+                    if(e.key.code >= sf::Keyboard::Num1 && e.key.code <= sf::Keyboard::Num4) {
+                        Player& p = players[e.key.code - sf::Keyboard::Num1];
+                        p.bot = !p.bot;
+                        updateMenuText();
+                    }
                 }
                 
                 if(state == MENU && e.type == sf::Event::MouseButtonPressed && e.mouseButton.button == sf::Mouse::Left) {
                     sf::Vector2i m = sf::Mouse::getPosition(win);
-                    if(btnStart.contains(m)) { state = PLAYING; updateUI("Space to Roll"); assets.sWin.play(); }
+                    if(btnStart.contains(m)) startMatch();
                     if(btnHelp.contains(m)) { showHelp = !showHelp; }
                     if(btnQuit.contains(m)) { win.close(); }
                 }
@@ -555,70 +839,255 @@ public:
                     if(btnRestart.contains(m)) { resetGame(); }
                 }
 
-                if(state == PLAYING) {
+                if(state == PLAYING && !players[curP].bot) {
+                    if(e.type == sf::Event::KeyPressed || e.type == sf::Event::MouseButtonPressed) { idleClock.restart(); players[curP].afkTurns = 0; }
                     if(!anim && e.type == sf::Event::KeyPressed) {
                         if(e.key.code == sf::Keyboard::Space && !rolled && state != ROLLING_DICE) startRoll(0);
                         if(e.key.code == sf::Keyboard::S && !rolled && state != ROLLING_DICE) startRoll(6);
                         if(e.key.code == sf::Keyboard::F) handleForfeit();
                     }
-                    if(!anim && rolled && e.type == sf::Event::MouseButtonPressed) {
-                        sf::Vector2i m = sf::Mouse::getPosition(win);
-                        for(auto& t : players[curP].tokens) {
-                            sf::Vector2f pos = getStepPos(curP, t.steps, t.id);
-                            if(std::hypot(m.x-pos.x, m.y-pos.y) < 30) {
-                                if(isValid(t)) startAnim(t);
-                            }
-                        }
-                    }
+                    if(!anim && rolled && e.type == sf::Event::MouseButtonPressed) clickToken(sf::Mouse::getPosition(win));
                 }
             }
 
-            if(state == ROLLING_DICE) updateDiceAnim();
-            if(anim) updateAnim();
+            if(state == PLAYING && !anim) updateTurnTimer();
+            if(journaled < matchLog.size() && journalClock.getElapsedTime().asSeconds() >= JOURNAL_FLUSH_TIME) flushJournal();
+            tweens.update(dt);
+            // effects advance in fixed steps; render() blends the leftover fraction
+            simTime = (state == MENU || state == GAME_OVER) ? simTime + dt : 0;
+            for(; simTime >= SIM_DT; simTime -= SIM_DT) simulate();
+
             if(state == MENU) {
-                menuAnim.update();
                 sf::Vector2i mouse = sf::Mouse::getPosition(win);
                 btnStart.update(mouse);
                 btnHelp.update(mouse);
                 btnQuit.update(mouse);
             }
             if(state == GAME_OVER) {
-                if(rand()%10==0) {
-                    sf::Color confettiColors[] = {C_RED, C_GREEN, C_YELLOW, C_BLUE, C_GOLD, C_WHITE};
-                    int randomX = rand() % WIN_W;
-                    int randomY = rand() % 200 + 100;
-                    fireworks.explode(randomX, randomY, confettiColors[rand()%6]);
-                }
-                fireworks.update();
                 sf::Vector2i mouse = sf::Mouse::getPosition(win);
                 btnRestart.update(mouse);
             }
-            render(); 
+            render(simTime / SIM_DT); 
+        }
+    }
+
+    // one fixed step of the menu and victory effects
+    void simulate() {
+        if(state == MENU) menuAnim.update(SIM_DT);
+        if(state == GAME_OVER) {
+            if(rand()%10==0) {
+                sf::Color confettiColors[] = {C_RED, C_GREEN, C_YELLOW, C_BLUE, C_GOLD, C_WHITE};
+                int randomX = rand() % WIN_W;
+                int randomY = rand() % 200 + 100;
+                fireworks.explode(randomX, randomY, confettiColors[rand()%6]);
+            }
+            fireworks.update(SIM_DT);
+        }
+    }
+
+    // anything that changes from frame to frame without input
+    bool isAnimating() {
+        return state != PLAYING || anim || tweens.count() > 0 || activityClock.getElapsedTime().asSeconds() < PULSE_TIME;
+    }
+
+    // time until the next timer in PLAYING needs the loop to run. these are the
+    // only idle state changes, so sleep straight through to the earliest one.
+    sf::Time nextWake() {
+        float wake = players[curP].bot ? SPEED_BOT_THINK[animSpeed] - botClock.getElapsedTime().asSeconds()
+                                       : AUTO_ROLL_TIME - idleClock.getElapsedTime().asSeconds();
+        if(journaled < matchLog.size()) wake = std::min(wake, JOURNAL_FLUSH_TIME - journalClock.getElapsedTime().asSeconds());
+        return sf::seconds(std::max(wake, 0.0f));
+    }
+
+    // SFML 2.5 has no waitEvent timeout, so poll with short sleeps until one arrives
+    bool waitEvent(sf::Event& e, sf::Time timeout) {
+        sf::Clock waitClock;
+        while(!win.pollEvent(e)) {
+            if(waitClock.getElapsedTime() >= timeout) return false;
+            sf::sleep(sf::milliseconds(10));
         }
+        return true;
+    }
+
+    // pulse strength, easing to a steady highlight once the board goes idle
+    float pulse(float speed) {
+        float wave = sin(textPulseClock.getElapsedTime().asSeconds() * speed);
+        if(!ON_DEMAND_RENDER) return wave;
+        float amp = std::max(0.0f, std::min(1.0f, PULSE_TIME - activityClock.getElapsedTime().asSeconds()));
+        return amp * wave + (1 - amp);
+    }
+
+    void startMatch() {
+        writeSeats(matchLog, botMask()); // seats may change in the menu, even on resume
+        state = PLAYING;
+        updateUI(rolled ? "Select Token" : "Space to Roll");
+        idleClock.restart();
+        botClock.restart();
+        idleTakeover = false;
+        assets.sWin.play();
+    }
+
+    // replay an interrupted match from the journal, keeping only whole messages
+    void recoverJournal() {
+        std::ifstream in(JOURNAL_FILE, std::ios::binary);
+        std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+
+        std::size_t off = 0;
+        MsgView m;
+        while(parseMsg(data.data() + off, data.size() - off, m) == PARSE_OK && applyMsg(m)) off += m.size();
+        matchLog.assign(data.begin(), data.begin() + off);
+        if(off > 0) btnStart.setup(assets.fontBold, "RESUME GAME", WIN_W/2 - 150, 500, 300, 60, C_GREEN);
+        updateMenuText(); // show the recovered seats
+
+        // rewrite the valid prefix so a torn tail is never appended to
+        journal.open(JOURNAL_FILE, std::ios::binary | std::ios::trunc);
+        journaled = 0;
+        flushJournal();
+    }
+
+    int botMask() const {
+        int mask = 0;
+        for(const auto& p : players) if(p.bot) mask |= 1 << p.id;
+        return mask;
+    }
+
+    bool applyMsg(const MsgView& m) {
+        if(m.type() == MSG_SEATS) {
+            if(m.botMask() >= 16) return false;
+            for(auto& p : players) p.bot = (m.botMask() >> p.id) & 1;
+            return true;
+        }
+        if(m.player() >= 4) return false;
+        if(m.type() == MSG_MOVE && (m.token() >= 4 || m.to() < -1 || m.to() > 56)) return false;
+        if(m.type() == MSG_CAPTURE && (m.victim() >= 4 || m.victimToken() >= 4)) return false;
+        if(m.type() == MSG_ROLL && (m.value() < 1 || m.value() > 6)) return false;
+        if(m.type() == MSG_FINISH && (m.rank() < 1 || m.rank() > 4)) return false;
+        Player& p = players[m.player()];
+        switch(m.type()) {
+            case MSG_ROLL: roll = m.value(); rolled = true; break;
+            case MSG_MOVE: {
+                Token& t = p.tokens[m.token()];
+                t.steps = m.to();
+                t.active = t.steps >= 0;
+                t.finished = t.steps == 56;
+                rolled = false;
+                break;
+            }
+            case MSG_CAPTURE: {
+                Token& t = players[m.victim()].tokens[m.victimToken()];
+                t.steps = -1; t.active = false;
+                p.killed = true;
+                p.captureCount++;
+                break;
+            }
+            case MSG_FINISH: p.finished = true; p.finalRank = m.rank(); rankList.push_back(p.name); break;
+            case MSG_FORFEIT: p.forfeited = true; break;
+            case MSG_TURN: curP = p.id; rolled = false; break;
+            default: return false;
+        }
+        return true;
+    }
+
+    // write pending deltas in one batch; called per turn or after JOURNAL_FLUSH_TIME
+    void flushJournal() {
+        if(journaled < matchLog.size()) {
+            journal.write((const char*)matchLog.data() + journaled, matchLog.size() - journaled);
+            journal.flush();
+            journaled = matchLog.size();
+        }
+        journalClock.restart();
     }
 
     void startRoll(int force) {
         state = ROLLING_DICE; 
-        rollClock.restart();
         assets.sRoll.play();
         roll = (force > 0) ? force : 0; 
+        Tween* tw = SPEED_ROLL_TIME[animSpeed] > 0 ? tweens.add(SPEED_ROLL_TIME[animSpeed]) : nullptr;
+        if(tw) tw->onDone = [this]{ endRoll(); };
+        else endRoll();
     }
 
-    void updateDiceAnim() {
-        if(rollClock.getElapsedTime().asSeconds() < 0.5f) {
-            if((int)(rollClock.getElapsedTime().asMilliseconds()) % 8 == 0) 
-                visualDice.draw(win, (rand()%6)+1, players[curP].col); 
-        } else {
-            state = PLAYING;
-            rolled = true;
-            if(roll == 0) roll = diceRoller.roll();
-            if(!canMove()) { rolled=false; nextTurn(); } 
-            else updateUI("Select Token");
+    void endRoll() {
+        state = PLAYING;
+        rolled = true;
+        if(roll == 0) roll = diceRoller.roll();
+        writeRoll(matchLog, curP, roll);
+        if(!canMove()) { rolled=false; nextTurn(); } 
+        else { updateUI("Select Token"); botClock.restart(); }
+    }
+
+    // bots play their own turns; a bot also takes over for an idle human,
+    // who forfeits after AFK_TURN_LIMIT idle turns in a row
+    void updateTurnTimer() {
+        Player& p = players[curP];
+        if(p.bot) {
+            if(botClock.getElapsedTime().asSeconds() >= SPEED_BOT_THINK[animSpeed]) botStep();
+            return;
+        }
+        if(idleClock.getElapsedTime().asSeconds() < AUTO_ROLL_TIME) return;
+        if(!idleTakeover) {
+            idleTakeover = true;
+            if(++p.afkTurns >= AFK_TURN_LIMIT) { handleForfeit(); return; }
+        }
+        botStep();
+    }
+
+    // roll, or move the best scoring token
+    void botStep() {
+        if(!rolled) { startRoll(0); return; }
+        Token* best = nullptr;
+        int bestScore = -1;
+        for(auto& t : players[curP].tokens) {
+            if(!isValid(t)) continue;
+            int score = scoreMove(t);
+            if(score > bestScore) { bestScore = score; best = &t; }
+        }
+        if(best) startAnim(*best);
+    }
+
+    // prefer captures, then finishing, leaving home, reaching safety, then the leading token
+    int scoreMove(Token& t) {
+        if(!t.active) return 100;
+        int to = t.steps + roll;
+        if(to == 56) return 150;
+        if(to > 50) return 60 + t.steps;
+        if(isSafe(to)) return 60 + t.steps;
+        if(!enemiesAt(to).empty()) return 200;
+        return t.steps;
+    }
+
+    // opponent tokens on the main track that share the square the current player lands on at step
+    std::vector<std::pair<Player*, Token*>> enemiesAt(int step) {
+        std::vector<std::pair<Player*, Token*>> found;
+        sf::Vector2f myPos = getStepPos(curP, step);
+        for(auto& opponent : players) {
+            if(opponent.id == curP || opponent.forfeited || opponent.finished) continue;
+            for(auto& enemyToken : opponent.tokens) {
+                if(!enemyToken.active || enemyToken.steps > 50) continue;
+                sf::Vector2f enemyPos = getStepPos(opponent.id, enemyToken.steps);
+                float positionTolerance = 5.0f;
+                if(std::abs(myPos.x - enemyPos.x) < positionTolerance &&
+                   std::abs(myPos.y - enemyPos.y) < positionTolerance) found.push_back({&opponent, &enemyToken});
+            }
         }
+        return found;
+    }
+
+    void updateMenuText() {
+        std::string s = "SEATS (1-4 to toggle):";
+        for(auto& p : players) s += "   " + p.name + (p.bot ? " CPU" : " HUMAN");
+        s += "      SPEED (T): " + std::string(SPEED_NAMES[animSpeed]);
+        txtSeats.setString(s);
+        sf::FloatRect sb = txtSeats.getLocalBounds();
+        txtSeats.setOrigin(sb.left + sb.width/2, 0);
+        txtSeats.setPosition(WIN_W/2, 760);
+        txtControls.setString("CONTROLS\n\nSpace : Roll Dice\nF : Forfeit Game\nT : Speed (" + std::string(SPEED_NAMES[animSpeed]) + ")");
     }
 
     void handleForfeit() {
         players[curP].forfeited = true;
+        writeForfeit(matchLog, curP);
         checkWinCondition();
         if(state != GAME_OVER) nextTurn();
     }
@@ -628,9 +1097,14 @@ public:
         for(const auto& p : players) if(!p.forfeited && !p.finished) activePlayers++;
 
         if(activePlayers <= 1) {
-            for(auto& p : players) if(!p.forfeited && !p.finished) { p.finished = true; rankList.push_back(p.name); }
+            for(auto& p : players) if(!p.forfeited && !p.finished) { 
+                p.finished = true; rankList.push_back(p.name); 
+                writeFinish(matchLog, p.id, rankList.size());
+            }
             state = GAME_OVER;
             assets.sWin.play();
+            journal.close();
+            std::remove(JOURNAL_FILE);
             
             std::string results;
             int rank = 1;
@@ -661,62 +1135,86 @@ public:
         return false;
     }
 
+    // move the current player's token under the mouse. stacked tokens share a
+    // square, so stop at the first one: at instant speed the move and the turn
+    // change have already happened when startAnim returns.
+    void clickToken(sf::Vector2i m) {
+        for(auto& t : players[curP].tokens) {
+            sf::Vector2f pos = getStepPos(curP, t.steps, t.id);
+            if(std::hypot(m.x-pos.x, m.y-pos.y) < 30 && isValid(t)) { startAnim(t); break; }
+        }
+    }
+
+    // normal speed hops square by square, turbo glides one curve through
+    // every square, instant applies the move straight away
     void startAnim(Token& t) {
+        if(anim) return; // one move per roll
         movingT = &t;
-        movesLeft = t.active ? roll : 1;
+        moveFrom = t.steps;
         anim = true;
-        prepStep();
+        int moves = t.active ? roll : 1;
+        Tween* tw = nullptr;
+        if(animSpeed == SPEED_NORMAL) tw = tweens.add(ANIM_TIME);
+        else if(animSpeed == SPEED_TURBO) tw = tweens.add(TURBO_MOVE_TIME);
+        if(!tw) { assets.sMove.play(); endMove(); return; }
+        tw->points = moves + 1;
+        for(int i=0; i<=moves; i++) tw->path[i] = getStepPos(curP, t.steps + i, t.id);
+        if(animSpeed == SPEED_TURBO) { tw->spline = true; tw->ease = EASE_IN_OUT; }
+        tw->hopHeight = 20;
+        tw->pos = &t.drawPos;
+        tw->hop = &t.lift;
+        tw->onStep = [this]{ assets.sMove.play(); };
+        tw->onDone = [this]{ endMove(); };
+        t.drawPos = tw->path[0];
+        t.tweening = true;
     }
 
-    void prepStep() {
-        if(movingT->steps == -1) { 
-            sf::Vector2f base = getStepPos(curP, -1, movingT->id);
-            animStart = base;
-            animEnd = getStepPos(curP, 0);
-        } else { 
-            animStart = getStepPos(curP, movingT->steps);
-            animEnd = getStepPos(curP, movingT->steps + 1);
+    void endMove() {
+        movingT->tweening = false;
+        movingT->lift = 0;
+        if(!movingT->active) {
+            movingT->active = true;
+            movingT->steps = 0;
+        } else {
+            movingT->steps += roll;
         }
-        clk.restart();
-        assets.sMove.play();
+        finalize();
     }
 
-    void updateAnim() {
-        if(clk.getElapsedTime().asSeconds() >= ANIM_TIME) {
-            if(!movingT->active) {
-                movingT->active = true;
-                movingT->steps = 0;
-            } else {
-                movingT->steps++;
-            }
-            movesLeft--;
-            if(movesLeft > 0) prepStep();
-            else finalize();
-        }
+    // a captured token flies back to its home slot; the game does not wait for it
+    void sendHome(Player& owner, Token& t) {
+        if(SPEED_CAPTURE_TIME[animSpeed] <= 0) return;
+        Tween* tw = tweens.add(SPEED_CAPTURE_TIME[animSpeed]);
+        if(!tw) return;
+        tw->points = 2;
+        tw->path[0] = getStepPos(owner.id, t.steps, t.id);
+        tw->path[1] = getStepPos(owner.id, -1, t.id);
+        tw->ease = EASE_OUT_QUAD;
+        tw->hopHeight = 60;
+        tw->pos = &t.drawPos;
+        tw->hop = &t.lift;
+        Token* tok = &t;
+        tw->onDone = [tok]{ tok->tweening = false; tok->lift = 0; };
+        t.drawPos = tw->path[0];
+        t.tweening = true;
     }
 
     // check for captures and update game state after move
     void finalize() {
         anim = false;
+        writeMove(matchLog, curP, movingT->id, moveFrom, movingT->steps);
         // check for captures on main track only
         if(movingT->steps <= 50 && !isSafe(movingT->steps)) {
-            sf::Vector2f myPos = getStepPos(curP, movingT->steps);
-            for(auto& opponent : players) {
-                if(opponent.id == curP || opponent.forfeited || opponent.finished) continue;
-                for(auto& enemyToken : opponent.tokens) {
-                    if(enemyToken.active && enemyToken.steps <= 50) {
-                        sf::Vector2f enemyPos = getStepPos(opponent.id, enemyToken.steps);
-                        float positionTolerance = 5.0f;
-                        if(std::abs(myPos.x - enemyPos.x) < positionTolerance && 
-                           std::abs(myPos.y - enemyPos.y) < positionTolerance) {
-                            enemyToken.active = false;
-                            enemyToken.steps = -1;
-                            players[curP].killed = true;
-                            players[curP].captureCount++;
-                            assets.sKill.play();
-                        }
-                    }
-                }
+            for(auto& enemy : enemiesAt(movingT->steps)) {
+                Player& opponent = *enemy.first;
+                Token& enemyToken = *enemy.second;
+                sendHome(opponent, enemyToken);
+                enemyToken.active = false;
+                enemyToken.steps = -1;
+                players[curP].killed = true;
+                players[curP].captureCount++;
+                writeCapture(matchLog, curP, opponent.id, enemyToken.id);
+                assets.sKill.play();
             }
         }
         
@@ -728,13 +1226,14 @@ public:
             players[curP].finished = true;
             rankList.push_back(players[curP].name);
             players[curP].finalRank = rankList.size();
+            writeFinish(matchLog, curP, players[curP].finalRank);
             checkWinCondition();
             if(state != GAME_OVER) nextTurn(); 
             return;
         }
 
         if(roll != 6) nextTurn();
-        else { rolled = false; updateUI("Roll 6: Go Again"); }
+        else { rolled = false; updateUI("Roll 6: Go Again"); botClock.restart(); }
     }
 
     bool isSafe(int s) {
@@ -749,6 +1248,11 @@ public:
             curP = (curP + 1) % 4;
             attempts++;
         } while ((players[curP].finished || players[curP].forfeited) && attempts < 5);
+        writeTurn(matchLog, curP);
+        flushJournal();
+        idleClock.restart();
+        botClock.restart();
+        idleTakeover = false;
         rolled = false; 
         updateUI("Space to Roll"); 
     }
@@ -760,20 +1264,32 @@ public:
             p.forfeited = false;
             p.finalRank = 0;
             p.captureCount = 0;
+            p.afkTurns = 0;
             for(auto& t : p.tokens) {
                 t.steps = -1;
                 t.active = false;
                 t.finished = false;
+                t.tweening = false;
+                t.lift = 0;
             }
         }
 
         rankList.clear();
+        matchLog.clear();
+        journal.close();
+        journal.open(JOURNAL_FILE, std::ios::binary | std::ios::trunc);
+        journaled = 0;
+        writeSeats(matchLog, botMask());
         curP = 0;
         roll = 1;
         rolled = false;
         anim = false;
+        tweens.clear();
         state = PLAYING;
         updateUI("Space to Roll");
+        idleClock.restart();
+        botClock.restart();
+        idleTakeover = false;
         assets.sWin.play();
     }
     
@@ -796,38 +1312,71 @@ public:
         else if(curP==1) turnHighlighter.setPosition(OFF_X+9*CELL, OFF_Y);
         else if(curP==2) turnHighlighter.setPosition(OFF_X+9*CELL, OFF_Y+9*CELL);
         else turnHighlighter.setPosition(OFF_X, OFF_Y+9*CELL);
+        panelDirty = true;
+        activityClock.restart();
     }
 
-    void render() {
+    // side panel and rank labels only change with turns, captures and finishes
+    void layoutPanel() {
+        float indicatorStartY = 530;
+        float indicatorX = WIN_W - UI_W + 200;
+        float basePos[4][2] = {{OFF_X+3*CELL, OFF_Y+3*CELL}, {OFF_X+12*CELL, OFF_Y+3*CELL}, 
+                               {OFF_X+12*CELL, OFF_Y+12*CELL}, {OFF_X+3*CELL, OFF_Y+12*CELL}};
+        std::string suffix[] = {"st", "nd", "rd", "th"};
+        indicatorGlow.setFillColor(players[curP].col);
+        indicatorGlow.setPosition(playerIndicators[curP].getPosition());
+        for(int i=0; i<4; i++) {
+            float rowY = indicatorStartY + i*100;
+            bool out = players[i].finished || players[i].forfeited;
+            playerIndicators[i].setFillColor(out ? sf::Color(80,80,80) : players[i].col);
+            // the current player's ring comes from indicatorGlow instead of an outline
+            playerIndicators[i].setOutlineThickness(i == curP ? 0 : 3);
+
+            playerLabels[i].setString(players[i].name + (players[i].bot ? " (CPU)" : ""));
+            sf::FloatRect labelBounds = playerLabels[i].getLocalBounds();
+            playerLabels[i].setOrigin(0, labelBounds.top + labelBounds.height/2);
+            playerLabels[i].setPosition(indicatorX + 40, rowY - 15);
+
+            captureCounters[i].setString("Kills: " + std::to_string(players[i].captureCount));
+            sf::FloatRect counterBounds = captureCounters[i].getLocalBounds();
+            captureCounters[i].setOrigin(0, counterBounds.top + counterBounds.height/2);
+            captureCounters[i].setPosition(indicatorX + 40, rowY + 15);
+
+            if(out) {
+                txtRankLabels[i].setString(players[i].forfeited ? "OUT" : std::to_string(players[i].finalRank) + suffix[std::min(players[i].finalRank-1, 3)]);
+                sf::FloatRect b = txtRankLabels[i].getLocalBounds();
+                txtRankLabels[i].setOrigin(b.left + b.width/2.0f, b.top + b.height/2.0f);
+                txtRankLabels[i].setPosition(basePos[i][0], basePos[i][1]);
+            }
+        }
+    }
+
+    void render(float alpha) {
         win.clear(C_BG);
 
         if(state == MENU) {
-            menuAnim.draw(win);
+            menuAnim.draw(win, alpha);
             win.draw(txtTitleShadow); win.draw(txtTitle);
             btnStart.draw(win);
             btnHelp.draw(win);
             btnQuit.draw(win);
+            win.draw(txtSeats);
             if(showHelp) { win.draw(helpOverlay); win.draw(txtHelp); }
         }
         else if (state == GAME_OVER) {
             win.draw(uiPanel);
-            for(int r=0;r<15;r++) for(int c=0;c<15;c++) win.draw(grid[r][c]);
-            
-            int starPos[8][2] = {{1,6}, {6,2}, {8,1}, {12,6}, {13,8}, {8,12}, {6,13}, {2,8}};
-            for(auto& pos : starPos) {
-                if(assets.hasImages) { sStar.setPosition(getGridPos(pos[0],pos[1])); win.draw(sStar); }
-                else { fallbackStar.setPosition(getGridPos(pos[0],pos[1])+sf::Vector2f(20,18)); win.draw(fallbackStar); }
-            }
-            if(assets.hasImages) win.draw(sCenter);
+            win.draw(boardSprite);
             
+            tokenBatch.begin(assets.atlas);
             for(auto& p : players) {
                 for(auto& t : p.tokens) {
                     sf::Vector2f pos = getStepPos(p.id, t.steps, t.id);
-                    t.draw(win, pos, 0, assets.hasImages, p.forfeited);
+                    t.draw(tokenBatch, win, pos, 0, assets.hasImages, p.forfeited);
                 }
             }
+            tokenBatch.draw(win);
             
-            fireworks.draw(win);
+            fireworks.draw(win, alpha);
             
             sf::RectangleShape gradTop({(float)WIN_W, WIN_H/3.0f});
             gradTop.setPosition(0, 0);
@@ -842,44 +1391,26 @@ public:
         }
         else {
             win.draw(uiPanel);
-            for(int r=0;r<15;r++) for(int c=0;c<15;c++) win.draw(grid[r][c]);
+            win.draw(boardSprite);
             
-            int alpha = 150 + 100 * sin(textPulseClock.getElapsedTime().asSeconds() * 5);
-            sf::Color bc = turnHighlighter.getOutlineColor(); bc.a = alpha;
+            // only the outline's vertex colours change here, not its geometry
+            int hlAlpha = 150 + 100 * pulse(5);
+            sf::Color bc = turnHighlighter.getOutlineColor(); bc.a = hlAlpha;
             turnHighlighter.setOutlineColor(bc);
             win.draw(turnHighlighter);
 
-            int starPos[8][2] = {{1,6}, {6,2}, {8,1}, {12,6}, {13,8}, {8,12}, {6,13}, {2,8}};
-            for(auto& pos : starPos) {
-                if(assets.hasImages) { sStar.setPosition(getGridPos(pos[0],pos[1])); win.draw(sStar); }
-                else { fallbackStar.setPosition(getGridPos(pos[0],pos[1])+sf::Vector2f(20,18)); win.draw(fallbackStar); }
-            }
-
-            if(assets.hasImages) win.draw(sCenter);
-
+            tokenBatch.begin(assets.atlas);
             for(auto& p : players) {
                 for(auto& t : p.tokens) {
-                    float u = (anim && movingT == &t) ? clk.getElapsedTime().asSeconds() / ANIM_TIME : 0;
-                    sf::Vector2f pos = (anim && movingT == &t) ? animStart + (animEnd - animStart) * u : getStepPos(p.id, t.steps, t.id);
-                    float yOff = (anim && movingT == &t) ? sin(u * 3.14159f) * 20.0f : 0;
-                    t.draw(win, pos, yOff, assets.hasImages, p.forfeited);
-                }
-
-                if(p.forfeited || p.finished) {
-                    float basePos[4][2] = {{OFF_X+3*CELL, OFF_Y+3*CELL}, {OFF_X+12*CELL, OFF_Y+3*CELL}, 
-                                           {OFF_X+12*CELL, OFF_Y+12*CELL}, {OFF_X+3*CELL, OFF_Y+12*CELL}};
-                    
-                    std::string suffix[] = {"st", "nd", "rd", "th"};
-                    std::string label = p.forfeited ? "OUT" : std::to_string(p.finalRank) + suffix[std::min(p.finalRank-1, 3)];
-                    txtRankLabel.setString(label);
-                    
-                    sf::FloatRect b = txtRankLabel.getLocalBounds();
-                    txtRankLabel.setOrigin(b.left + b.width/2.0f, b.top + b.height/2.0f);
-                    txtRankLabel.setPosition(basePos[p.id][0], basePos[p.id][1]);
-                    txtRankLabel.setFillColor(C_WHITE);
-                    win.draw(txtRankLabel);
+                    sf::Vector2f pos = t.tweening ? t.drawPos : getStepPos(p.id, t.steps, t.id);
+                    float yOff = t.tweening ? t.lift : 0;
+                    t.draw(tokenBatch, win, pos, yOff, assets.hasImages, p.forfeited);
                 }
             }
+            tokenBatch.draw(win);
+
+            if(panelDirty) { layoutPanel(); panelDirty = false; }
+            for(auto& p : players) if(p.forfeited || p.finished) win.draw(txtRankLabels[p.id]);
 
             if(state == ROLLING_DICE) {
                 visualDice.draw(win, (rand()%6)+1, players[curP].col);
@@ -889,35 +1420,15 @@ public:
 
             win.draw(txtTurn); win.draw(txtInfo); win.draw(txtControls);
             
-            float indicatorStartY = 530;
-            float indicatorX = WIN_W - UI_W + 200;
+            // glow ring of 5 +/- 3 px around the 25 px indicator
+            float glow = 5 + 3 * pulse(6);
+            sf::Vector2f gc = indicatorGlow.getPosition();
+            sf::RenderStates glowStates;
+            glowStates.transform.scale((25 + glow) / (25 + 8), (25 + glow) / (25 + 8), gc.x, gc.y);
+            win.draw(indicatorGlow, glowStates);
             for(int i=0; i<4; i++) {
-                float rowY = indicatorStartY + i*100;
-                
-                playerIndicators[i].setFillColor(players[i].col);
-                if(i == curP) {
-                    float glow = 5 + 3 * sin(textPulseClock.getElapsedTime().asSeconds() * 6);
-                    playerIndicators[i].setOutlineThickness(glow);
-                    playerIndicators[i].setOutlineColor(players[i].col);
-                } else {
-                    playerIndicators[i].setOutlineThickness(3);
-                    playerIndicators[i].setOutlineColor(C_WHITE);
-                }
-                if(players[i].finished || players[i].forfeited) {
-                    playerIndicators[i].setFillColor(sf::Color(80,80,80));
-                }
                 win.draw(playerIndicators[i]);
-                
-                playerLabels[i].setString(players[i].name);
-                sf::FloatRect labelBounds = playerLabels[i].getLocalBounds();
-                playerLabels[i].setOrigin(0, labelBounds.top + labelBounds.height/2);
-                playerLabels[i].setPosition(indicatorX + 40, rowY - 15);
                 win.draw(playerLabels[i]);
-                
-                captureCounters[i].setString("Kills: " + std::to_string(players[i].captureCount));
-                sf::FloatRect counterBounds = captureCounters[i].getLocalBounds();
-                captureCounters[i].setOrigin(0, counterBounds.top + counterBounds.height/2);
-                captureCounters[i].setPosition(indicatorX + 40, rowY + 15);
                 win.draw(captureCounters[i]);
             }
         }
@@ -926,8 +1437,10 @@ public:
 };
 
 
+#ifndef LUDO_NO_MAIN
 int main() { 
     Game g; 
     g.run(); 
     return 0; 
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+// replaying a journal must restore the match up to the first bad message and
+// drop everything after it. opens the game window once per case; run from the project root.
+#define LUDO_NO_MAIN
+#define LUDO_JOURNAL_FILE "journal_replay_test.journal"
+#include "../src/main.cpp"
+
+struct GameTest {
+    // write a recorded journal to disk and let a fresh Game recover it
+    static std::unique_ptr<Game> replay(const std::vector<std::uint8_t>& journal) {
+        std::ofstream out(JOURNAL_FILE, std::ios::binary | std::ios::trunc);
+        out.write((const char*)journal.data(), journal.size());
+        out.close();
+        return std::unique_ptr<Game>(new Game());
+    }
+
+    static bool kept(const char* name, Game& g, std::size_t prefix) {
+        std::ifstream in(JOURNAL_FILE, std::ios::binary | std::ios::ate);
+        std::size_t onDisk = (std::size_t)in.tellg();
+        if(g.matchLog.size() == prefix && onDisk == prefix) return true;
+        std::cout << name << ": kept " << g.matchLog.size() << " bytes (" << onDisk << " on disk), expected " << prefix << "\n";
+        return false;
+    }
+
+    static bool run() {
+        bool ok = true;
+        auto check = [&](const char* name, bool cond, const char* what) {
+            if(!cond) { std::cout << name << ": " << what << "\n"; ok = false; }
+        };
+
+        // a whole recorded match with a torn last message
+        {
+            std::vector<std::uint8_t> j;
+            writeSeats(j, 0x6);
+            writeRoll(j, 0, 6); writeMove(j, 0, 0, -1, 0);
+            writeRoll(j, 0, 4); writeMove(j, 0, 0, 0, 4); writeTurn(j, 1);
+            writeRoll(j, 1, 6); writeMove(j, 1, 2, -1, 0); writeCapture(j, 1, 0, 0); writeTurn(j, 2);
+            writeFinish(j, 3, 1);
+            writeRoll(j, 2, 5);
+            std::size_t prefix = j.size();
+            writeMove(j, 2, 1, -1, 0);
+            j.resize(j.size() - 2);
+
+            auto g = replay(j);
+            const char* n = "torn tail";
+            ok = kept(n, *g, prefix) && ok;
+            check(n, g->curP == 2 && g->rolled && g->roll == 5, "turn or pending roll not restored");
+            check(n, g->players[0].tokens[0].steps == -1 && !g->players[0].tokens[0].active, "captured token not at home");
+            check(n, g->players[1].tokens[2].steps == 0 && g->players[1].tokens[2].active, "moved token not restored");
+            check(n, g->players[2].tokens[1].steps == -1, "torn move was applied");
+            check(n, g->players[1].killed && g->players[1].captureCount == 1, "capture not credited");
+            check(n, g->players[3].finished && g->players[3].finalRank == 1, "finish rank not restored");
+            check(n, !g->players[0].bot && g->players[1].bot && g->players[2].bot && !g->players[3].bot, "seats not restored");
+        }
+
+        // rolls a die cannot show
+        for(int bad : { 0, 7 }) {
+            std::vector<std::uint8_t> j;
+            writeSeats(j, 0x1);
+            writeRoll(j, 0, 6); writeMove(j, 0, 0, -1, 0); writeTurn(j, 1);
+            std::size_t prefix = j.size();
+            writeRoll(j, 1, bad); writeMove(j, 1, 0, -1, 0);
+
+            auto g = replay(j);
+            const char* n = bad == 0 ? "roll 0" : "roll 7";
+            ok = kept(n, *g, prefix) && ok;
+            check(n, g->curP == 1 && !g->rolled, "bad roll was applied");
+            check(n, g->players[0].tokens[0].steps == 0, "moves before the bad roll lost");
+            check(n, g->players[1].tokens[0].steps == -1, "move after the bad roll applied");
+            check(n, g->players[0].bot, "seats lost");
+        }
+
+        // a rank past the last place
+        {
+            std::vector<std::uint8_t> j;
+            writeSeats(j, 0x0);
+            writeRoll(j, 0, 2);
+            std::size_t prefix = j.size();
+            writeFinish(j, 0, 5); writeTurn(j, 1);
+
+            auto g = replay(j);
+            const char* n = "rank 5";
+            ok = kept(n, *g, prefix) && ok;
+            check(n, !g->players[0].finished && g->players[0].finalRank == 0, "bad rank was applied");
+            check(n, g->curP == 0 && g->rolled && g->roll == 2, "turn after the bad rank applied");
+        }
+
+        // more seats than players
+        {
+            std::vector<std::uint8_t> j;
+            writeSeats(j, 0x1F);
+            writeRoll(j, 0, 6);
+
+            auto g = replay(j);
+            const char* n = "seats 0x1F";
+            ok = kept(n, *g, 0) && ok;
+            check(n, !g->rolled, "roll after the bad seats applied");
+            for(auto& p : g->players) check(n, !p.bot, "bad seats were applied");
+        }
+        return ok;
+    }
+};
+
+int main() {
+    bool ok = GameTest::run();
+    std::remove(JOURNAL_FILE);
+    std::cout << (ok ? "journal replay: ok\n" : "journal replay: FAILED\n");
+    return ok ? 0 : 1;
+}
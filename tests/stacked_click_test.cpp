@@ -0,0 +1,51 @@
+// clicking a square with two of your own tokens must move exactly one of them,
+// at every animation speed. opens the game window briefly; run from the project root.
+#define LUDO_NO_MAIN
+#define LUDO_JOURNAL_FILE "stacked_click_test.journal"
+#include "../src/main.cpp"
+
+struct GameTest {
+    static bool stackedClick(Game& g, AnimSpeed speed) {
+        g.resetGame();
+        g.animSpeed = speed;
+        Player& red = g.players[0];
+        for(int i=0; i<2; i++) { red.tokens[i].active = true; red.tokens[i].steps = 0; }
+        g.roll = 3;
+        g.rolled = true;
+
+        sf::Vector2f square = getStepPos(0, 0);
+        g.clickToken(sf::Vector2i((int)square.x, (int)square.y));
+        for(int frame=0; frame<600 && (g.anim || g.tweens.count() > 0); frame++) g.tweens.update(1.0f / 60);
+
+        int moves = 0;
+        std::size_t off = 0;
+        MsgView m;
+        while(parseMsg(g.matchLog.data() + off, g.matchLog.size() - off, m) == PARSE_OK) {
+            if(m.type() == MSG_MOVE) moves++;
+            off += m.size();
+        }
+
+        bool ok = true;
+        auto check = [&](bool cond, const char* what) {
+            if(!cond) { std::cout << SPEED_NAMES[speed] << ": " << what << "\n"; ok = false; }
+        };
+        check(red.tokens[0].steps == 3, "clicked token did not move by the roll");
+        check(red.tokens[1].steps == 0, "second stacked token moved");
+        check(!red.tokens[0].tweening && !red.tokens[1].tweening, "token left mid-animation");
+        check(g.curP == 1, "turn did not pass to exactly the next player");
+        check(moves == 1, "move logged more than once");
+        return ok;
+    }
+};
+
+int main() {
+    std::remove(JOURNAL_FILE);
+    bool ok = true;
+    {
+        Game g;
+        for(int s=0; s<SPEED_COUNT; s++) ok = GameTest::stackedClick(g, (AnimSpeed)s) && ok;
+    }
+    std::remove(JOURNAL_FILE);
+    std::cout << (ok ? "stacked click: ok\n" : "stacked click: FAILED\n");
+    return ok ? 0 : 1;
+}